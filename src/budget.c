@@ -0,0 +1,46 @@
+#include "budget.h"
+
+void startBudget(BudgetContext *budgetContext, __uint32_t ticks)
+{
+    budgetContext->start = HZ_200;
+    budgetContext->ticks = ticks;
+    budgetContext->extended = 0;
+}
+
+int budgetedRequests(BudgetContext *budgetContext, int requests, int failed_requests)
+{
+    if (failed_requests == 0 && requests >= ZERO_ERRORS_REQUESTS)
+    {
+        return requests + 1; // Clean enough, stop early
+    }
+    if (failed_requests >= CONFIDENCE_ERRORS)
+    {
+        return requests + 1; // The error rate is already known, stop early
+    }
+    if (budgetContext->ticks == 0)
+    {
+        return requests + 1; // No budget left to scale to
+    }
+    if (failed_requests > 0 && !budgetContext->extended)
+    {
+        // First errors: spend more time on this test to measure the error rate
+        if (budgetContext->ticks <= 0xFFFFFFFF / BUDGET_EXTENSION)
+        {
+            budgetContext->ticks *= BUDGET_EXTENSION;
+        }
+        budgetContext->extended = 1;
+    }
+
+    __uint32_t elapsed = HZ_200 - budgetContext->start;
+    if (elapsed == 0 || requests < BUDGET_CALIBRATION_REQUESTS)
+    {
+        return requests + BUDGET_CALIBRATION_REQUESTS + 1; // Too early to measure the throughput
+    }
+
+    // Scale the requests to fill the budget at the measured throughput
+    __uint32_t requests_per_tick = ((__uint32_t)requests + 1) / elapsed;
+    __uint32_t planned = requests_per_tick > 0x7FFFFFFF / budgetContext->ticks
+                             ? 0x7FFFFFFF
+                             : requests_per_tick * budgetContext->ticks;
+    return planned > (__uint32_t)requests ? (int)planned : requests + 1;
+}
@@ -0,0 +1,29 @@
+#ifndef BUDGET_H_
+#define BUDGET_H_
+
+#include <sys/types.h>
+
+#define HZ_200 (*(volatile unsigned long *)0x4BA) // 200Hz system timer (supervisor mode only)
+
+/* EARLY STOP AND EXTENSION RULES */
+#define BUDGET_EXTENSION 4           // Budget multiplier once the first errors appear
+#define CONFIDENCE_ERRORS 64         // 1.96 / sqrt(64): error rate known within +-25% with 95% confidence
+#define ZERO_ERRORS_REQUESTS 300000  // Rule of three: error rate below 1e-5 with 95% confidence
+#define BUDGET_CALIBRATION_REQUESTS 4096
+#define MAX_TIME_BUDGET 3600         // Seconds. Keeps the extended budget in 200Hz ticks far from overflow
+
+typedef struct BudgetContext BudgetContext;
+struct BudgetContext
+{
+    __uint32_t start;     // HZ_200 when the test started
+    __uint32_t ticks;     // Time budget of the test in 200Hz ticks
+    __uint16_t extended;  // 1 once the budget was extended because of errors
+};
+
+// starts the time budget of a test (works only in supervisor mode)
+void startBudget(BudgetContext *budgetContext, __uint32_t ticks);
+
+// returns the total number of requests the test should perform, given the requests done and the failures seen
+int budgetedRequests(BudgetContext *budgetContext, int requests, int failed_requests);
+
+#endif
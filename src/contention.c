@@ -0,0 +1,157 @@
+#include <osbind.h>
+#include <string.h>
+#include "contention.h"
+
+static volatile __uint32_t timerInterrupts = 0;
+static volatile __uint32_t floppySectors = 0;
+static volatile __uint16_t floppyActive = 0;
+static volatile __uint16_t floppySector = 1;
+
+static unsigned char dmaSoundBuffer[DMA_SOUND_BUFFER_SIZE] __attribute__((aligned(2)));
+static unsigned char floppyBuffer[FLOPPY_SECTOR_SIZE] __attribute__((aligned(2)));
+
+// looks for a cookie in the cookie jar (works only in supervisor mode)
+static int getCookie(__uint32_t cookie, __uint32_t *value)
+{
+    __uint32_t *jar = *COOKIE_JAR_ADDRESS;
+    if (jar == NULL)
+    {
+        return 0;
+    }
+    for (; jar[0] != 0; jar += 2)
+    {
+        if (jar[0] == cookie)
+        {
+            *value = jar[1];
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// programs the DMA chip and the FDC to read the next sector of the track from drive A into floppyBuffer.
+// Single sector reads finish right after the sector, a read multiple would wait ~1s for a Record Not Found
+static void startFloppyRead()
+{
+    unsigned long address = (unsigned long)floppyBuffer;
+    *DMA_ADDRESS_LOW = address & 0xFF;
+    *DMA_ADDRESS_MID = (address >> 8) & 0xFF;
+    *DMA_ADDRESS_HIGH = (address >> 16) & 0xFF;
+
+    // Toggle the direction to flush the FIFO and leave it in read mode
+    *DMA_MODE = DMA_MODE_SECTOR_COUNT;
+    *DMA_MODE = DMA_MODE_TOGGLE;
+    *DMA_MODE = DMA_MODE_SECTOR_COUNT;
+    *DMA_DATA = 1;
+
+    *DMA_MODE = DMA_MODE_FDC_SECTOR;
+    *DMA_DATA = floppySector;
+    *DMA_MODE = DMA_MODE_FDC_COMMAND;
+    *DMA_DATA = FDC_READ_SECTOR;
+    floppySector = floppySector < FLOPPY_SECTORS ? floppySector + 1 : 1;
+}
+
+// moves the head of drive A to track 0, so the reads find their sectors. Returns 1 if track 0 was found
+static int restoreFloppy()
+{
+    *DMA_MODE = DMA_MODE_FDC_COMMAND;
+    *DMA_DATA = FDC_RESTORE;
+
+    unsigned long start = HZ_200;
+    while (*MFP_GPIP & MFP_GPIP_FDC)
+    {
+        if (HZ_200 - start > FDC_RESTORE_TIMEOUT)
+        {
+            *DMA_DATA = FDC_FORCE_INTERRUPT;
+            (void)*DMA_DATA;
+            return 0;
+        }
+    }
+    return !(*DMA_DATA & FDC_SEEK_ERROR); // Reading the status also clears the FDC interrupt request
+}
+
+// Timer A interrupt handler. Counts the interrupts and restarts the floppy read when the FDC is done.
+static void __attribute__((interrupt)) timerAHandler()
+{
+    timerInterrupts++;
+    if (floppyActive && !(*MFP_GPIP & MFP_GPIP_FDC))
+    {
+        // Reading the status register clears the FDC interrupt request
+        *DMA_MODE = DMA_MODE_FDC_COMMAND;
+        if (!(*DMA_DATA & FDC_READ_ERRORS))
+        {
+            floppySectors++;
+        }
+        startFloppyRead();
+    }
+    *MFP_ISRA = ~MFP_TIMER_A_ISR_MASK; // End of interrupt
+}
+
+static void startDMASound()
+{
+    unsigned long start = (unsigned long)dmaSoundBuffer;
+    unsigned long end = start + DMA_SOUND_BUFFER_SIZE;
+
+    memset(dmaSoundBuffer, 0, DMA_SOUND_BUFFER_SIZE); // Silence, but the DMA still fetches every sample
+
+    *DMA_SOUND_CONTROL = 0;
+    *DMA_SOUND_START_HIGH = (start >> 16) & 0xFF;
+    *DMA_SOUND_START_MID = (start >> 8) & 0xFF;
+    *DMA_SOUND_START_LOW = start & 0xFF;
+    *DMA_SOUND_END_HIGH = (end >> 16) & 0xFF;
+    *DMA_SOUND_END_MID = (end >> 8) & 0xFF;
+    *DMA_SOUND_END_LOW = end & 0xFF;
+    *DMA_SOUND_MODE = DMA_SOUND_MONO_50KHZ;
+    *DMA_SOUND_CONTROL = DMA_SOUND_PLAY_LOOP;
+}
+
+void startContention(ContentionContext *contentionContext)
+{
+    __uint32_t snd = 0;
+
+    timerInterrupts = 0;
+    floppySectors = 0;
+    floppySector = 1;
+
+    contentionContext->dmaSound = getCookie(COOKIE_SND, &snd) && (snd & SND_DMA_8BIT);
+    if (contentionContext->dmaSound)
+    {
+        contentionContext->savedSoundMode = *DMA_SOUND_MODE;
+        startDMASound();
+    }
+
+    // Lock the floppy VBL routine out while we own the DMA chip
+    *FLOCK_ADDRESS = 1;
+    Ongibit(FLOPPY_DRIVE_A_SIDE_0);
+    Offgibit(FLOPPY_DRIVE_A_SELECT);
+    if (restoreFloppy())
+    {
+        startFloppyRead();
+        floppyActive = 1;
+    }
+
+    contentionContext->savedTimerAVector = (void (*)(void))Setexc(MFP_TIMER_A_VECTOR, -1);
+    Xbtimer(MFP_TIMER_A, MFP_TIMER_A_CONTROL, MFP_TIMER_A_DATA, timerAHandler);
+}
+
+void stopContention(ContentionContext *contentionContext)
+{
+    Jdisint(MFP_TIMER_A_INT);
+    Setexc(MFP_TIMER_A_VECTOR, contentionContext->savedTimerAVector);
+
+    floppyActive = 0;
+    *DMA_MODE = DMA_MODE_FDC_COMMAND;
+    *DMA_DATA = FDC_FORCE_INTERRUPT;
+    (void)*DMA_DATA;
+    Ongibit(FLOPPY_DESELECT);
+    *FLOCK_ADDRESS = 0;
+
+    if (contentionContext->dmaSound)
+    {
+        *DMA_SOUND_CONTROL = 0;
+        *DMA_SOUND_MODE = contentionContext->savedSoundMode;
+    }
+
+    contentionContext->timerInterrupts = timerInterrupts;
+    contentionContext->floppySectors = floppySectors;
+}
@@ -0,0 +1,79 @@
+#ifndef CONTENTION_H_
+#define CONTENTION_H_
+
+#include <sys/types.h>
+
+/* SYSTEM VARIABLES */
+#define FLOCK_ADDRESS (volatile __uint16_t *)0x43E
+#define COOKIE_JAR_ADDRESS (__uint32_t **)0x5A0
+#define COOKIE_SND 0x5F534E44 // '_SND'
+#define SND_DMA_8BIT 0x02     // _SND bit for the STE 8 bit DMA sound
+#ifndef HZ_200
+#define HZ_200 (*(volatile unsigned long *)0x4BA) // 200Hz system timer (supervisor mode only)
+#endif
+
+/* MFP DEFINITIONS */
+#define MFP_GPIP (volatile unsigned char *)0xFFFA01
+#define MFP_ISRA (volatile unsigned char *)0xFFFA0F
+#define MFP_GPIP_FDC 0x20          // GPIP5 goes low when the FDC/ACSI controller finished
+#define MFP_TIMER_A 0              // Xbtimer timer number
+#define MFP_TIMER_A_INT 13         // Jdisint interrupt number
+#define MFP_TIMER_A_VECTOR (0x134 / 4) // Setexc vector number
+#define MFP_TIMER_A_ISR_MASK 0x20  // In-service bit of Timer A in ISRA
+#define MFP_TIMER_A_CONTROL 1      // Delay mode, prescaler /4
+#define MFP_TIMER_A_DATA 48        // 2.4576MHz / 4 / 48 = 12.8KHz
+
+/* STE DMA SOUND DEFINITIONS */
+#define DMA_SOUND_CONTROL (volatile unsigned char *)0xFF8901
+#define DMA_SOUND_START_HIGH (volatile unsigned char *)0xFF8903
+#define DMA_SOUND_START_MID (volatile unsigned char *)0xFF8905
+#define DMA_SOUND_START_LOW (volatile unsigned char *)0xFF8907
+#define DMA_SOUND_END_HIGH (volatile unsigned char *)0xFF890F
+#define DMA_SOUND_END_MID (volatile unsigned char *)0xFF8911
+#define DMA_SOUND_END_LOW (volatile unsigned char *)0xFF8913
+#define DMA_SOUND_MODE (volatile unsigned char *)0xFF8921
+#define DMA_SOUND_PLAY_LOOP 0x03   // Play and repeat
+#define DMA_SOUND_MONO_50KHZ 0x83  // Mono, 50066Hz: the highest DMA load
+#define DMA_SOUND_BUFFER_SIZE 8192
+
+/* FLOPPY DMA DEFINITIONS */
+#define DMA_DATA (volatile __uint16_t *)0xFF8604
+#define DMA_MODE (volatile __uint16_t *)0xFF8606
+#define DMA_ADDRESS_HIGH (volatile unsigned char *)0xFF8609
+#define DMA_ADDRESS_MID (volatile unsigned char *)0xFF860B
+#define DMA_ADDRESS_LOW (volatile unsigned char *)0xFF860D
+#define DMA_MODE_SECTOR_COUNT 0x090 // Read direction, sector count register
+#define DMA_MODE_TOGGLE 0x190       // Write direction, used to flush the DMA FIFO
+#define DMA_MODE_FDC_COMMAND 0x080  // Read direction, FDC command/status register
+#define DMA_MODE_FDC_SECTOR 0x084   // Read direction, FDC sector register
+#define FDC_RESTORE 0x03            // Seek track 0, 3ms step rate
+#define FDC_READ_SECTOR 0x80        // Read a single sector
+#define FDC_SEEK_ERROR 0x10         // Status after a Restore: track 0 not found
+#define FDC_READ_ERRORS 0x1C        // Status after a read: Record Not Found, CRC error or Lost Data
+#define FDC_RESTORE_TIMEOUT 600     // 200Hz ticks. Includes the motor spin-up
+#define FDC_FORCE_INTERRUPT 0xD0    // Abort the current command
+#define FLOPPY_DRIVE_A_SIDE_0 0x05  // PSG port A bits to set: side 0, drive B deselected
+#define FLOPPY_DRIVE_A_SELECT 0xFD  // PSG port A mask to clear: drive A selected
+#define FLOPPY_DESELECT 0x06        // PSG port A bits to set: both drives deselected
+#define FLOPPY_SECTORS 9            // Sectors per track, the reads loop over them
+#define FLOPPY_SECTOR_SIZE 512
+
+typedef struct ContentionContext ContentionContext;
+struct ContentionContext
+{
+    __uint32_t timerInterrupts; // Timer A interrupts served while the contention was active
+    __uint32_t floppySectors;   // Floppy sectors read without errors while the contention was active
+    __uint16_t dmaSound;        // 1 if the STE DMA sound was playing, 0 otherwise
+    __uint16_t savedSoundMode;  // DMA sound mode before the contention started
+    void (*savedTimerAVector)(void);
+};
+
+// starts the bus contention sources: MFP Timer A, STE DMA sound and a looping floppy DMA read
+// from track 0 of drive A. The floppy load is skipped if the drive does not find track 0
+// (works only in supervisor mode)
+void startContention(ContentionContext *contentionContext);
+
+// stops all the bus contention sources and collects the counters into the context
+void stopContention(ContentionContext *contentionContext);
+
+#endif
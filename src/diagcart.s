@@ -0,0 +1,130 @@
+; ATARI ST SIDECART ROM TEST - Diagnostic cartridge
+;
+; TOS jumps to $FA0004 very early in the boot when it finds the diagnostic
+; magic number at $FA0000, before the memory controller is configured and
+; before GEMDOS exists. So this code can't use RAM nor the stack: only
+; registers, the ROM itself and the hardware registers.
+;
+; The rest of the cartridge is filled by generate_diag_cart.py with the output
+; of a 32 bit Galois LFSR. The same LFSR runs here, so the check does not need
+; any file with the expected data. The result is shown in the background color:
+;   blue    checking, alternating with cyan on every pass
+;   green   all passes succeeded. The boot continues after a short delay
+;   red     mismatch in ROM 4 ($FA0000-$FAFFFF). Blinks slowly and halts
+;   yellow  mismatch in ROM 3 ($FB0000-$FBFFFF). Blinks fast and halts
+;
+; A monochrome monitor only shows bit 0 of color 0, so every color above has
+; bit 0 set and the alternate/off colors have it clear: the screen inverts on
+; every pass and blinks on a mismatch. Before TOS runs the Shifter is still
+; in low resolution, which the SM124 can't sync to, so it is switched to high
+; resolution when GPIP7 reports a monochrome monitor.
+
+ROM_START       equ $FA0000
+ROM3_START      equ ROM_START+$10000
+DATA_START      equ ROM_START+$400          ; Keep in sync with generate_diag_cart.py
+DATA_END        equ ROM_START+$20000
+DATA_LONGS      equ (DATA_END-DATA_START)/4
+
+DIAG_MAGIC      equ $FA52235F
+LFSR_SEED       equ $5AD1C0DE               ; Keep in sync with generate_diag_cart.py
+LFSR_TAPS       equ $80200003               ; x^32 + x^22 + x^2 + x + 1
+	ifnd PASSES
+PASSES          equ 1                       ; About 1.2s per pass at 8MHz. Set with make DIAG_PASSES=n
+	endif
+
+MFP_GPIP        equ $FFFA01
+GPIP_MONO       equ 7                       ; 0 when a monochrome monitor is plugged
+SHIFTER_RES     equ $FF8260
+HIGH_RES        equ 2
+
+PALETTE0        equ $FF8240
+COLOR_RUNNING   equ $007
+COLOR_RUNNING_ALT equ $066                  ; Bit 0 clear: inverts the monochrome screen
+COLOR_PASS      equ $071
+COLOR_FAIL_ROM4 equ $701
+COLOR_FAIL_ROM3 equ $771
+COLOR_OFF       equ $000
+PASS_DELAY      equ $40000                  ; Roughly half a second at 8MHz
+BLINK_SLOW      equ $40000
+BLINK_FAST      equ $10000
+
+	org ROM_START
+
+	dc.l DIAG_MAGIC
+
+start:
+	move.w #$2700,sr                        ; Nothing is configured yet, no interrupts
+	btst #GPIP_MONO,MFP_GPIP
+	bne.s .colour
+	move.b #HIGH_RES,SHIFTER_RES            ; The SM124 needs the 71Hz high resolution
+.colour:
+	move.l #LFSR_TAPS,d1
+	move.w #PASSES-1,d7
+
+pass:
+	; Show the progress: blue on even passes, cyan on odd ones
+	move.w #COLOR_RUNNING,PALETTE0
+	btst #0,d7
+	beq.s .show_pass
+	move.w #COLOR_RUNNING_ALT,PALETTE0
+.show_pass:
+
+	; Long words access
+	move.l #LFSR_SEED,d0
+	lea DATA_START,a0
+	move.w #DATA_LONGS-1,d2
+.longs:
+	lsr.l #1,d0                             ; Next LFSR value
+	bcc.s .long_taps
+	eor.l d1,d0
+.long_taps:
+	cmp.l (a0)+,d0
+	bne.s fail
+	dbra d2,.longs
+
+	; Bytes access, same sequence
+	move.l #LFSR_SEED,d0
+	lea DATA_START,a0
+	move.w #DATA_LONGS-1,d2
+.bytes:
+	lsr.l #1,d0                             ; Next LFSR value
+	bcc.s .byte_taps
+	eor.l d1,d0
+.byte_taps:
+	moveq #3,d3
+.byte:
+	rol.l #8,d0                             ; Most significant byte first. 4 rotations restore d0
+	cmp.b (a0)+,d0
+	bne.s fail
+	dbra d3,.byte
+	dbra d2,.bytes
+
+	dbra d7,pass
+
+	move.w #COLOR_PASS,PALETTE0
+	move.l #PASS_DELAY,d2
+.wait:
+	subq.l #1,d2
+	bne.s .wait
+	jmp (a6)                                ; Carry on with the TOS boot
+
+fail:
+	; a0 points past the mismatch
+	move.w #COLOR_FAIL_ROM4,d0
+	move.l #BLINK_SLOW,d3
+	cmp.l #ROM3_START,a0
+	bls.s .blink
+	move.w #COLOR_FAIL_ROM3,d0
+	move.l #BLINK_FAST,d3
+.blink:
+	move.w d0,PALETTE0
+	move.l d3,d2
+.on:
+	subq.l #1,d2
+	bne.s .on
+	move.w #COLOR_OFF,PALETTE0
+	move.l d3,d2
+.off:
+	subq.l #1,d2
+	bne.s .off
+	bra.s .blink
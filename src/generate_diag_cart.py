@@ -0,0 +1,28 @@
+import struct
+
+CART_SIZE = 128 * 1024  # 128 KBytes, ROM 4 and ROM 3
+DATA_OFFSET = 0x400  # Keep in sync with DATA_START in diagcart.s
+LFSR_SEED = 0x5AD1C0DE  # Keep in sync with diagcart.s
+LFSR_TAPS = 0x80200003
+
+# Read the assembled diagnostic code
+with open("build/diagcart.bin", "rb") as code_file:
+    code = code_file.read()
+
+if len(code) > DATA_OFFSET:
+    raise SystemExit("Diagnostic code is %d bytes, it must fit in %d bytes" % (len(code), DATA_OFFSET))
+
+cart_data = bytearray(code.ljust(DATA_OFFSET, b"\0"))
+
+# Fill the rest of the cartridge with the same LFSR sequence the code checks
+lfsr = LFSR_SEED
+for _ in range((CART_SIZE - DATA_OFFSET) // 4):
+    carry = lfsr & 1
+    lfsr >>= 1
+    if carry:
+        lfsr ^= LFSR_TAPS
+    cart_data += struct.pack(">I", lfsr)
+
+# Write the cartridge image
+with open("dist/DIAGCART.BIN", "wb") as binary_file:
+    binary_file.write(cart_data)
@@ -1,9 +1,13 @@
 #include <sys/types.h>
 #include <stdio.h>
+#include <stdlib.h>
 
 #include <time.h>
 
 #include "screen.h"
+#include "contention.h"
+#include "remote.h"
+#include "budget.h"
 
 #define ROM_MEMORY_START 0xFA0000;
 #define ROM4_MEMORY_START ROM_MEMORY_START
@@ -25,9 +29,42 @@
 #define ADDRESS_LINE_ITERATIONS 1000000
 #endif
 
+#define TESTS 18                   // 9 tests for each ROM bank
+#define ALL_TESTS_MASK 0x3FFFFUL   // One bit per test number
+#define ADDRESS_LINES 14           // A1 to A14
+#define MAX_ITERATIONS 100000000   // Keeps the bytes read by the address line tests within 32 bits
+
 const int SPINNER_UPDATE_FREQUENCY = 4096;
 char spinner[] = {'\\', '|', '/', '-'};
 
+const char *test_names[TESTS / 2] = {
+    "seq words",
+    "stats seq words",
+    "seq bytes",
+    "stats seq bytes",
+    "rnd words",
+    "stats rnd words",
+    "rnd bytes",
+    "stats rnd bytes",
+    "addr lines",
+};
+
+int contention_mode = 0; // Set with the -C command line option
+int remote_mode = 0;     // Set with the -R command line option
+
+int random_access_iterations = RANDOM_ACCESS_ITERATIONS;
+int address_line_iterations = ADDRESS_LINE_ITERATIONS;
+unsigned long random_seed = 0; // 0 takes a new seed from XBIOS Random() on every test
+unsigned long time_budget = 0; // Time budget of each test in 200Hz ticks. 0 runs the fixed iterations
+const char *invalid_budget = NULL; // -B argument that could not be parsed, reported once the screen is ready
+BudgetContext budgetContext;
+
+// Returns the seed for the next random test
+unsigned long nextRandomSeed()
+{
+    return random_seed != 0 ? random_seed : Random();
+}
+
 int testDifferentVersions(unsigned char *rom_data)
 {
     // Check if the content of the version string is the same in the ROM
@@ -60,9 +97,10 @@ int testDifferentVersions(unsigned char *rom_data)
  * @param rom_data A pointer to the start address of the data read from ROM 4.
  * @param file_data A pointer to the start address of the expected data.
  * @param rombank The ROM bank number to be tested. Use the constants ROM4_BANK and ROM3_BANK.
+ * @param requests_done Returns the number of requests performed, also when a mismatch stops the test.
  * @return Returns 0 if all data matches, 1 if a mismatch is found.
  */
-int testSequentialReadROM(unsigned char *rom_data, unsigned char *file_data, int rombank)
+int testSequentialReadROM(unsigned char *rom_data, unsigned char *file_data, int rombank, unsigned long *requests_done)
 {
     printf("- Testing sequential read ROM %s...  ", rombank == ROM4_BANK ? "4" : "3");
     __uint16_t *rom_data_words = (__uint16_t *)rom_data;   // Assuming rom_data was previously defined as unsigned char*
@@ -78,6 +116,7 @@ int testSequentialReadROM(unsigned char *rom_data, unsigned char *file_data, int
             unsigned long real_memory = rombank * ROMBANK_SIZE_BYTES + ROM4_MEMORY_START;
             real_memory += i * 2;
             printf("\r\n    x Error: Data mismatch at address %p. Expected: %p, got: %p\r\n", real_memory, file_word, rom_word);
+            *requests_done = i + 1; // Requests done until the mismatch
             return 1;
         }
         if (i % SPINNER_UPDATE_FREQUENCY == 0)
@@ -85,6 +124,7 @@ int testSequentialReadROM(unsigned char *rom_data, unsigned char *file_data, int
             printf("\b%c", spinner[(i / SPINNER_UPDATE_FREQUENCY) % 4]);
         }
     }
+    *requests_done = ROMBANK_SIZE_WORDS;
     printf("\bSuccess.\r\n");
     return 0;
 }
@@ -98,9 +138,10 @@ int testSequentialReadROM(unsigned char *rom_data, unsigned char *file_data, int
  * @param rom_data A pointer to the start address of the data read from ROM.
  * @param file_data A pointer to the start address of the expected data.
  * @param rombank The ROM bank number to be tested. Use the constants ROM4_BANK and ROM3_BANK.
- * @return Returns 0 if all data matches, 1 if there were mismatches.
+ * @param requests_done Returns the number of requests performed, also when a mismatch stops the test.
+ * @return Returns the number of failed requests, 0 if all data matches.
  */
-int testSequentialReadROMStats(unsigned char *rom_data, unsigned char *file_data, int rombank)
+int testSequentialReadROMStats(unsigned char *rom_data, unsigned char *file_data, int rombank, unsigned long *requests_done)
 {
     int successful_requests = 0;
     int failed_requests = 0;
@@ -132,11 +173,12 @@ int testSequentialReadROMStats(unsigned char *rom_data, unsigned char *file_data
         }
     }
 
+    *requests_done = ROMBANK_SIZE_WORDS;
     printf("\bSuccess: %d, Fail: %d\r\n",
            successful_requests,
            failed_requests);
 
-    return failed_requests > 0 ? 1 : 0;
+    return failed_requests;
 }
 
 /**
@@ -150,10 +192,11 @@ int testSequentialReadROMStats(unsigned char *rom_data, unsigned char *file_data
  * @param rom_data A pointer to the start address of the data read from ROM.
  * @param file_data A pointer to the start address of the expected data.
  * @param rombank The ROM bank number to be tested. Use constants like ROM4_BANK and ROM3_BANK.
- * @param num_requests The number of random access requests to be performed.
+ * @param num_requests The number of random access requests to be performed, unless time_budget is set.
+ * @param requests_done Returns the number of requests performed, also when a mismatch stops the test.
  * @return Returns 0 if all data matches, 1 if a mismatch is found.
  */
-int testRandomReadROM(unsigned char *rom_data, unsigned char *file_data, int rombank, int num_requests)
+int testRandomReadROM(unsigned char *rom_data, unsigned char *file_data, int rombank, int num_requests, unsigned long *requests_done)
 {
     printf("- Testing %i random access from ROM %s...  ", num_requests, rombank == ROM4_BANK ? "4" : "3");
 
@@ -162,7 +205,11 @@ int testRandomReadROM(unsigned char *rom_data, unsigned char *file_data, int rom
     rom_data_words += rombank * ROMBANK_SIZE_WORDS;
     file_data_words += rombank * ROMBANK_SIZE_WORDS;
 
-    srand(Random()); // Initialize random seed
+    srand(nextRandomSeed()); // Initialize random seed
+    if (time_budget)
+    {
+        startBudget(&budgetContext, time_budget);
+    }
 
     for (int i = 0; i < num_requests; i++)
     {
@@ -176,16 +223,29 @@ int testRandomReadROM(unsigned char *rom_data, unsigned char *file_data, int rom
             unsigned long real_memory = rombank * ROMBANK_SIZE_BYTES + ROM4_MEMORY_START;
             real_memory += random_position * 2;
             printf("\r\n    x Error: Data mismatch at %p. Expected: %p, got: %p\r\n", real_memory, file_word, rom_word);
+            *requests_done = i + 1; // Requests done until the mismatch
             return 1;
         }
 
         if (i % SPINNER_UPDATE_FREQUENCY == 0)
         {
             printf("\b%c", spinner[(i / SPINNER_UPDATE_FREQUENCY) % 4]);
+            if (time_budget)
+            {
+                num_requests = budgetedRequests(&budgetContext, i, 0);
+            }
         }
     }
 
-    printf("\bSuccess.\r\n");
+    *requests_done = num_requests;
+    if (time_budget)
+    {
+        printf("\bSuccess: %d\r\n", num_requests);
+    }
+    else
+    {
+        printf("\bSuccess.\r\n");
+    }
     return 0;
 }
 
@@ -200,10 +260,11 @@ int testRandomReadROM(unsigned char *rom_data, unsigned char *file_data, int rom
  * @param rom_data A pointer to the start address of the data read from ROM.
  * @param file_data A pointer to the start address of the expected data.
  * @param rombank The ROM bank number to be tested. Use constants like ROM4_BANK and ROM3_BANK.
- * @param num_requests The number of random access requests to be performed.
- * @return Returns 0 if all data matches, 1 if there were mismatches.
+ * @param num_requests The number of random access requests to be performed, unless time_budget is set.
+ * @param requests_done Returns the number of requests performed, also when a mismatch stops the test.
+ * @return Returns the number of failed requests, 0 if all data matches.
  */
-int testRandomReadROMStats(unsigned char *rom_data, unsigned char *file_data, int rombank, int num_requests)
+int testRandomReadROMStats(unsigned char *rom_data, unsigned char *file_data, int rombank, int num_requests, unsigned long *requests_done)
 {
     int successful_requests = 0;
     int failed_requests = 0;
@@ -215,7 +276,11 @@ int testRandomReadROMStats(unsigned char *rom_data, unsigned char *file_data, in
     rom_data_words += rombank * ROMBANK_SIZE_WORDS;
     file_data_words += rombank * ROMBANK_SIZE_WORDS;
 
-    srand(Random()); // Initialize random seed
+    srand(nextRandomSeed()); // Initialize random seed
+    if (time_budget)
+    {
+        startBudget(&budgetContext, time_budget);
+    }
 
     for (int i = 0; i < num_requests; i++)
     {
@@ -236,14 +301,19 @@ int testRandomReadROMStats(unsigned char *rom_data, unsigned char *file_data, in
         if (i % SPINNER_UPDATE_FREQUENCY == 0)
         {
             printf("\b%c", spinner[(i / SPINNER_UPDATE_FREQUENCY) % 4]);
+            if (time_budget)
+            {
+                num_requests = budgetedRequests(&budgetContext, i, failed_requests);
+            }
         }
     }
 
+    *requests_done = num_requests;
     printf("\bSuccess: %d, Fail: %d\r\n",
            successful_requests,
            failed_requests);
 
-    return failed_requests > 0 ? 1 : 0;
+    return failed_requests;
 }
 
 /**
@@ -255,10 +325,11 @@ int testRandomReadROMStats(unsigned char *rom_data, unsigned char *file_data, in
  * @param rom_data A pointer to the start address of the data read from ROM.
  * @param file_data A pointer to the start address of the expected data.
  * @param rombank The ROM bank number to be tested. Use the constants ROM4_BANK and ROM3_BANK.
- * @param num_requests The number of times each address line is tested.
+ * @param num_requests The number of times each address line is tested, unless time_budget is set.
+ * @param requests_done Returns the number of requests performed, also when a mismatch stops the test.
  * @return Returns 0 if all data matches, 1 if a mismatch is found.
  */
-int testAddressLinesSequentialReadROM(unsigned char *rom_data, unsigned char *file_data, int rombank, int num_requests)
+int testAddressLinesSequentialReadROM(unsigned char *rom_data, unsigned char *file_data, int rombank, int num_requests, unsigned long *requests_done)
 {
     printf("- Testing addr lines seq read ROM %s with %d req x line...  ", rombank == ROM4_BANK ? "4" : "3", num_requests);
 
@@ -267,10 +338,17 @@ int testAddressLinesSequentialReadROM(unsigned char *rom_data, unsigned char *fi
     rom_data_words += rombank * ROMBANK_SIZE_WORDS;
     file_data_words += rombank * ROMBANK_SIZE_WORDS;
 
+    unsigned long total_requests = 0;
+
     // Can't read from A0 high, so start at A1
     for (int line = 1; line < 15; line++) // Loop over each address line
     {
-        for (int request = 0; request < num_requests; request++)
+        int line_requests = num_requests;
+        if (time_budget)
+        {
+            startBudget(&budgetContext, time_budget / ADDRESS_LINES); // Same share of the budget for each line
+        }
+        for (int request = 0; request < line_requests; request++)
         {
             int address = 1 << line;                              // This will set the current line high and all other lines low
             __uint16_t rom_word = rom_data_words[address >> 1];   // Divide by 2 to get the word address
@@ -280,9 +358,15 @@ int testAddressLinesSequentialReadROM(unsigned char *rom_data, unsigned char *fi
                 unsigned long real_memory = rombank * ROMBANK_SIZE_BYTES + ROM4_MEMORY_START;
                 real_memory += address;
                 printf("\r\n    x Error: Data mismatch at %p with only A%d high. Expected: %p, got: %p\r\n", real_memory, line, file_word, rom_word);
+                *requests_done = total_requests + request + 1; // Requests done until the mismatch
                 return 1;
             }
+            if (time_budget && request % SPINNER_UPDATE_FREQUENCY == 0)
+            {
+                line_requests = budgetedRequests(&budgetContext, request, 0);
+            }
         }
+        total_requests += line_requests;
 
         // Spinner update
         if (line % SPINNER_UPDATE_FREQUENCY == 0)
@@ -291,7 +375,15 @@ int testAddressLinesSequentialReadROM(unsigned char *rom_data, unsigned char *fi
         }
     }
 
-    printf("\bSuccess.\r\n");
+    *requests_done = total_requests;
+    if (time_budget)
+    {
+        printf("\bSuccess: %lu\r\n", total_requests);
+    }
+    else
+    {
+        printf("\bSuccess.\r\n");
+    }
     return 0;
 }
 
@@ -306,9 +398,10 @@ int testAddressLinesSequentialReadROM(unsigned char *rom_data, unsigned char *fi
  * @param rom_data   A pointer to the start address of the data read from ROM.
  * @param file_data  A pointer to the start address of the expected data.
  * @param rombank    The ROM bank number to be tested (e.g., ROM4_BANK, ROM3_BANK).
+ * @param requests_done Returns the number of requests performed, also when a mismatch stops the test.
  * @return           Returns 0 if all data matches, 1 if a mismatch is found.
  */
-int testSequentialReadROMBytes(unsigned char *rom_data, unsigned char *file_data, int rombank)
+int testSequentialReadROMBytes(unsigned char *rom_data, unsigned char *file_data, int rombank, unsigned long *requests_done)
 {
     printf("- Testing seq read bytes ROM %s...  ", rombank == ROM4_BANK ? "4" : "3");
 
@@ -326,6 +419,7 @@ int testSequentialReadROMBytes(unsigned char *rom_data, unsigned char *file_data
             real_memory += i;
 
             printf("\r\n    x Error: Data mismatch at address %lx. Expected: %02x, got: %02x\r\n", real_memory, file_byte, rom_byte);
+            *requests_done = i + 1; // Requests done until the mismatch
             return 1;
         }
 
@@ -335,6 +429,7 @@ int testSequentialReadROMBytes(unsigned char *rom_data, unsigned char *file_data
         }
     }
 
+    *requests_done = ROMBANK_SIZE_BYTES;
     printf("\bSuccess.\r\n");
     return 0;
 }
@@ -352,9 +447,10 @@ int testSequentialReadROMBytes(unsigned char *rom_data, unsigned char *file_data
  * @param rom_data   A pointer to the start address of the data read from ROM.
  * @param file_data  A pointer to the start address of the expected data.
  * @param rombank    The ROM bank number to be tested (e.g., ROM4_BANK, ROM3_BANK).
- * @return           Returns the number of successful requests (matches).
+ * @param requests_done Returns the number of requests performed, also when a mismatch stops the test.
+ * @return           Returns the number of failed requests, 0 if all data matches.
  */
-int testSequentialReadROMBytesStats(unsigned char *rom_data, unsigned char *file_data, int rombank)
+int testSequentialReadROMBytesStats(unsigned char *rom_data, unsigned char *file_data, int rombank, unsigned long *requests_done)
 {
     int successful_requests = 0;
     int failed_requests = 0;
@@ -384,11 +480,12 @@ int testSequentialReadROMBytesStats(unsigned char *rom_data, unsigned char *file
         }
     }
 
+    *requests_done = ROMBANK_SIZE_BYTES;
     printf("\bSuccess: %d, Fail: %d\r\n",
            successful_requests,
            failed_requests);
 
-    return failed_requests > 0 ? 1 : 0;
+    return failed_requests;
 }
 
 /**
@@ -402,17 +499,22 @@ int testSequentialReadROMBytesStats(unsigned char *rom_data, unsigned char *file
  * @param rom_data     A pointer to the start address of the data read from ROM.
  * @param file_data    A pointer to the start address of the expected data.
  * @param rombank      The ROM bank number to be tested (e.g., ROM4_BANK, ROM3_BANK).
- * @param num_requests The number of random access requests to perform.
+ * @param num_requests The number of random access requests to perform, unless time_budget is set.
+ * @param requests_done Returns the number of requests performed, also when a mismatch stops the test.
  * @return             Returns 0 if all random bytes match, 1 if a mismatch is found.
  */
-int testRandomReadROMBytes(unsigned char *rom_data, unsigned char *file_data, int rombank, int num_requests)
+int testRandomReadROMBytes(unsigned char *rom_data, unsigned char *file_data, int rombank, int num_requests, unsigned long *requests_done)
 {
     printf("- Testing %i random access bytes from ROM %s...  ", num_requests, rombank == ROM4_BANK ? "4" : "3");
 
     rom_data += rombank * ROMBANK_SIZE_BYTES;  // Move the pointer to the start of the ROM bank
     file_data += rombank * ROMBANK_SIZE_BYTES; // Move the pointer to the start of the ROM bank in the file
 
-    srand(Random()); // Initialize random seed
+    srand(nextRandomSeed()); // Initialize random seed
+    if (time_budget)
+    {
+        startBudget(&budgetContext, time_budget);
+    }
 
     for (int i = 0; i < num_requests; i++)
     {
@@ -426,16 +528,29 @@ int testRandomReadROMBytes(unsigned char *rom_data, unsigned char *file_data, in
             unsigned long real_memory = rombank * ROMBANK_SIZE_BYTES + ROM4_MEMORY_START;
             real_memory += random_position;
             printf("\r\n    x Error: Data mismatch at %p. Expected: %p, got: %p\r\n", real_memory, file_byte, rom_byte);
+            *requests_done = i + 1; // Requests done until the mismatch
             return 1;
         }
 
         if (i % SPINNER_UPDATE_FREQUENCY == 0)
         {
             printf("\b%c", spinner[(i / SPINNER_UPDATE_FREQUENCY) % 4]);
+            if (time_budget)
+            {
+                num_requests = budgetedRequests(&budgetContext, i, 0);
+            }
         }
     }
 
-    printf("\bSuccess.\r\n");
+    *requests_done = num_requests;
+    if (time_budget)
+    {
+        printf("\bSuccess: %d\r\n", num_requests);
+    }
+    else
+    {
+        printf("\bSuccess.\r\n");
+    }
     return 0;
 }
 
@@ -450,10 +565,11 @@ int testRandomReadROMBytes(unsigned char *rom_data, unsigned char *file_data, in
  * @param rom_data     A pointer to the start address of the data read from ROM.
  * @param file_data    A pointer to the start address of the expected data.
  * @param rombank      The ROM bank number to be tested (e.g., ROM4_BANK, ROM3_BANK).
- * @param num_requests The number of random access requests to perform.
- * @return             Returns 0 if all random bytes match, 1 if any mismatches found.
+ * @param num_requests The number of random access requests to perform, unless time_budget is set.
+ * @param requests_done Returns the number of requests performed, also when a mismatch stops the test.
+ * @return             Returns the number of failed requests, 0 if all random bytes match.
  */
-int testRandomReadROMBytesStats(unsigned char *rom_data, unsigned char *file_data, int rombank, int num_requests)
+int testRandomReadROMBytesStats(unsigned char *rom_data, unsigned char *file_data, int rombank, int num_requests, unsigned long *requests_done)
 {
     int successful_requests = 0;
     int failed_requests = 0;
@@ -463,7 +579,11 @@ int testRandomReadROMBytesStats(unsigned char *rom_data, unsigned char *file_dat
     rom_data += rombank * ROMBANK_SIZE_BYTES;  // Move the pointer to the start of the ROM bank
     file_data += rombank * ROMBANK_SIZE_BYTES; // Move the pointer to the start of the ROM bank in the file
 
-    srand(Random()); // Initialize random seed
+    srand(nextRandomSeed()); // Initialize random seed
+    if (time_budget)
+    {
+        startBudget(&budgetContext, time_budget);
+    }
 
     for (int i = 0; i < num_requests; i++)
     {
@@ -484,14 +604,310 @@ int testRandomReadROMBytesStats(unsigned char *rom_data, unsigned char *file_dat
         if (i % SPINNER_UPDATE_FREQUENCY == 0)
         {
             printf("\b%c", spinner[(i / SPINNER_UPDATE_FREQUENCY) % 4]);
+            if (time_budget)
+            {
+                num_requests = budgetedRequests(&budgetContext, i, failed_requests);
+            }
         }
     }
 
+    *requests_done = num_requests;
     printf("\bSuccess: %d, Fail: %d\r\n",
            successful_requests,
            failed_requests);
 
-    return failed_requests > 0 ? 1 : 0;
+    return failed_requests;
+}
+
+// Bytes read by each request of a test: words or bytes access
+int requestSize(int test)
+{
+    return ((test >> 1) & 2) ? 1 : 2;
+}
+
+/**
+ * Runs one of the ROM tests by its test number.
+ *
+ * Even test numbers use ROM 4 and odd numbers ROM 3. The test numbers follow
+ * the order of the standard run, see test_names.
+ *
+ * @param test       The test number, from 0 to TESTS - 1.
+ * @param rom_data   A pointer to the start address of the data read from ROM.
+ * @param file_data  A pointer to the start address of the expected data.
+ * @param bytes_read Returns the number of bytes read from the ROM by the test.
+ * @return           Returns the number of failed requests. Tests that stop at the first mismatch return 0 or 1.
+ */
+int runTest(int test, unsigned char *rom_data, unsigned char *file_data, unsigned long *bytes_read)
+{
+    int rombank = (test & 1) ? ROM3_BANK : ROM4_BANK;
+    unsigned long requests_done = 0;
+    int failed_requests;
+    switch (test >> 1)
+    {
+    case 0:
+        failed_requests = testSequentialReadROM(rom_data, file_data, rombank, &requests_done);
+        break;
+    case 1:
+        failed_requests = testSequentialReadROMStats(rom_data, file_data, rombank, &requests_done);
+        break;
+    case 2:
+        failed_requests = testSequentialReadROMBytes(rom_data, file_data, rombank, &requests_done);
+        break;
+    case 3:
+        failed_requests = testSequentialReadROMBytesStats(rom_data, file_data, rombank, &requests_done);
+        break;
+    case 4:
+        failed_requests = testRandomReadROM(rom_data, file_data, rombank, random_access_iterations, &requests_done);
+        break;
+    case 5:
+        failed_requests = testRandomReadROMStats(rom_data, file_data, rombank, random_access_iterations, &requests_done);
+        break;
+    case 6:
+        failed_requests = testRandomReadROMBytes(rom_data, file_data, rombank, random_access_iterations, &requests_done);
+        break;
+    case 7:
+        failed_requests = testRandomReadROMBytesStats(rom_data, file_data, rombank, random_access_iterations, &requests_done);
+        break;
+    default:
+        failed_requests = testAddressLinesSequentialReadROM(rom_data, file_data, rombank, address_line_iterations, &requests_done);
+        break;
+    }
+    *bytes_read = requests_done * requestSize(test);
+    return failed_requests;
+}
+
+// Stats tests count all the mismatches instead of stopping at the first one
+int isStatsTest(int test)
+{
+    return (test >> 1) < 8 && ((test >> 1) & 1);
+}
+
+// Converts failed requests to failures per million requests
+unsigned long failuresPerMillion(int failed_requests, unsigned long requests)
+{
+    return requests == 0 ? 0 : (unsigned long)((unsigned long long)failed_requests * 1000000 / requests);
+}
+
+// Converts bytes read in a number of 200Hz ticks to bytes per second
+unsigned long throughput(unsigned long bytes_read, unsigned long ticks)
+{
+    return ticks == 0 ? 0 : (bytes_read / ticks) * 200;
+}
+
+/**
+ * Runs the stats tests twice: first in the quiet Supexec context and then with the
+ * bus contention sources active (MFP Timer A interrupt, STE DMA sound and a looping
+ * floppy DMA read). Prints the throughput and the failed requests of both runs and
+ * their deltas. Timing-marginal boards usually fail only in the second run.
+ *
+ * @param rom_data   A pointer to the start address of the data read from ROM.
+ * @param file_data  A pointer to the start address of the expected data.
+ * @return           Returns the number of failed requests under contention.
+ */
+int testContention(unsigned char *rom_data, unsigned char *file_data)
+{
+    unsigned long bytes_read[2][TESTS];
+    unsigned long ticks[2][TESTS];
+    int failed_requests[2][TESTS];
+    int total_failed = 0;
+    ContentionContext contentionContext;
+
+    for (int pass = 0; pass < 2; pass++)
+    {
+        printf(pass == 0 ? "- Quiet run:\r\n" : "- Contention run:\r\n");
+        if (pass == 1)
+        {
+            startContention(&contentionContext);
+        }
+        for (int test = 0; test < TESTS; test++)
+        {
+            if (!isStatsTest(test))
+            {
+                continue;
+            }
+            unsigned long start = HZ_200;
+            failed_requests[pass][test] = runTest(test, rom_data, file_data, &bytes_read[pass][test]);
+            ticks[pass][test] = HZ_200 - start;
+        }
+        if (pass == 1)
+        {
+            stopContention(&contentionContext);
+        }
+    }
+
+    printf("- Contention: %lu timer interrupts, %lu floppy sectors, DMA sound %s\r\n",
+           contentionContext.timerInterrupts,
+           contentionContext.floppySectors,
+           contentionContext.dmaSound ? "on" : "not available");
+    if (contentionContext.floppySectors == 0)
+    {
+        printf("    x Warning: no floppy sector read, there was no floppy DMA load. Insert a disk in drive A\r\n");
+    }
+
+    for (int test = 0; test < TESTS; test++)
+    {
+        if (!isStatsTest(test))
+        {
+            continue;
+        }
+        unsigned long quiet = throughput(bytes_read[0][test], ticks[0][test]);
+        unsigned long busy = throughput(bytes_read[1][test], ticks[1][test]);
+        printf("    %s ROM %s: %lu -> %lu bytes/s (%ld), ",
+               test_names[test >> 1],
+               (test & 1) ? "3" : "4",
+               quiet,
+               busy,
+               (long)busy - (long)quiet);
+        if (time_budget)
+        {
+            // The budget runs a different number of requests on each pass: compare rates
+            unsigned long quiet_ppm = failuresPerMillion(failed_requests[0][test], bytes_read[0][test] / requestSize(test));
+            unsigned long busy_ppm = failuresPerMillion(failed_requests[1][test], bytes_read[1][test] / requestSize(test));
+            printf("fail %lu -> %lu ppm (%ld)\r\n", quiet_ppm, busy_ppm, (long)busy_ppm - (long)quiet_ppm);
+        }
+        else
+        {
+            printf("fail %d -> %d (%d)\r\n",
+                   failed_requests[0][test],
+                   failed_requests[1][test],
+                   failed_requests[1][test] - failed_requests[0][test]);
+        }
+        total_failed += failed_requests[1][test];
+    }
+
+    return total_failed;
+}
+
+/**
+ * Parses a time budget in seconds and converts it to 200Hz ticks.
+ *
+ * @param text The number of seconds, only decimal digits are accepted.
+ * @param ticks The time budget in 200Hz ticks. Not modified if the text is invalid.
+ * @return 1 if the text is a number of seconds between 0 and MAX_TIME_BUDGET, 0 otherwise.
+ */
+int parseTimeBudget(const char *text, unsigned long *ticks)
+{
+    char *end;
+    long seconds = strtol(text, &end, 10);
+    if (end == text || *end != '\0' || seconds < 0 || seconds > MAX_TIME_BUDGET)
+    {
+        return 0;
+    }
+    *ticks = seconds * 200;
+    return 1;
+}
+
+/**
+ * Serves the remote control commands received from the RS-232 port until QUIT.
+ *
+ * Commands and records are ASCII lines terminated with CR/LF. After the HELLO greeting
+ * the station sends VER OK <version>, or ERR version <rom version> if the ROM does not
+ * match the program.
+ *   SEED <n>     Seed for the random tests. 0 takes a new seed from XBIOS Random() on every test.
+ *   ITER <n>     Iterations of the random access and address line tests.
+ *   BUDGET <n>   Time budget in seconds of the random access and address line tests. 0 uses ITER.
+ *   TESTS <mask> Bit mask of the test numbers to run (hex with 0x prefix).
+ *   LIST         Sends a TEST <number> <rom> <name> record per test.
+ *   RUN          Runs the selected tests. Sends a RES <number> <failed> <bytes> <ticks> record
+ *                per test and END <total failed> at the end. A version mismatch counts as a failure.
+ *   QUIT         Sends BYE and leaves the remote mode.
+ * Every other command is answered with OK or ERR <reason>.
+ *
+ * @param rom_data   A pointer to the start address of the data read from ROM.
+ * @param file_data  A pointer to the start address of the expected data.
+ * @param version_failed The result of testDifferentVersions().
+ */
+void runRemote(unsigned char *rom_data, unsigned char *file_data, int version_failed)
+{
+    char line[REMOTE_LINE_SIZE];
+    char record[REMOTE_LINE_SIZE];
+    char rom_version[12]; // 11 characters + null terminator
+    unsigned long test_mask = ALL_TESTS_MASK;
+
+    sprintf(record, "HELLO TESTSCRT %s", VERSION);
+    sendRemoteLine(record);
+
+    memcpy(rom_version, &rom_data[4], 11);
+    rom_version[11] = '\0';
+    sprintf(record, version_failed ? "ERR version %s" : "VER OK %s", rom_version);
+    sendRemoteLine(record);
+
+    for (;;)
+    {
+        readRemoteLine(line, sizeof(line));
+        printf("- Remote command: %s\r\n", line);
+
+        if (strncmp(line, "SEED ", 5) == 0)
+        {
+            random_seed = strtoul(&line[5], NULL, 0);
+            sendRemoteLine("OK");
+        }
+        else if (strncmp(line, "ITER ", 5) == 0)
+        {
+            long iterations = strtol(&line[5], NULL, 0);
+            if (iterations <= 0 || iterations > MAX_ITERATIONS)
+            {
+                sprintf(record, "ERR iterations must be between 1 and %d", MAX_ITERATIONS);
+                sendRemoteLine(record);
+                continue;
+            }
+            random_access_iterations = iterations;
+            address_line_iterations = iterations;
+            sendRemoteLine("OK");
+        }
+        else if (strncmp(line, "BUDGET ", 7) == 0)
+        {
+            if (!parseTimeBudget(&line[7], &time_budget))
+            {
+                sprintf(record, "ERR budget must be between 0 and %d seconds", MAX_TIME_BUDGET);
+                sendRemoteLine(record);
+                continue;
+            }
+            sendRemoteLine("OK");
+        }
+        else if (strncmp(line, "TESTS ", 6) == 0)
+        {
+            test_mask = strtoul(&line[6], NULL, 0) & ALL_TESTS_MASK;
+            sendRemoteLine("OK");
+        }
+        else if (strcmp(line, "LIST") == 0)
+        {
+            for (int test = 0; test < TESTS; test++)
+            {
+                sprintf(record, "TEST %d %s %s", test, (test & 1) ? "3" : "4", test_names[test >> 1]);
+                sendRemoteLine(record);
+            }
+            sendRemoteLine("OK");
+        }
+        else if (strcmp(line, "RUN") == 0)
+        {
+            int total_failed = version_failed;
+            for (int test = 0; test < TESTS; test++)
+            {
+                if (!(test_mask & (1UL << test)))
+                {
+                    continue;
+                }
+                unsigned long bytes_read;
+                unsigned long start = HZ_200;
+                int failed = runTest(test, rom_data, file_data, &bytes_read);
+                sprintf(record, "RES %d %d %lu %lu", test, failed, bytes_read, HZ_200 - start);
+                sendRemoteLine(record);
+                total_failed += failed;
+            }
+            sprintf(record, "END %d", total_failed);
+            sendRemoteLine(record);
+        }
+        else if (strcmp(line, "QUIT") == 0)
+        {
+            sendRemoteLine("BYE");
+            return;
+        }
+        else
+        {
+            sendRemoteLine("ERR unknown command");
+        }
+    }
 }
 
 int load_binary_file(unsigned char **data, long *file_size)
@@ -560,7 +976,29 @@ int run()
     printf("\r");
     printf("ATARI ST SIDECART ROM TEST. V%s - (C)2023 Diego Parrilla / @soyparrilla\r\n", VERSION);
 
+    if (remote_mode)
+    {
+        initRemote();
+    }
+
+    if (invalid_budget != NULL)
+    {
+        printf("x Error: invalid time budget %s. Use -B<seconds> between 0 and %d\r\n", invalid_budget, MAX_TIME_BUDGET);
+        if (remote_mode)
+        {
+            sendRemoteLine("ERR invalid time budget");
+        }
+        else
+        {
+            printf("Press any key to exit...\r\n");
+            getchar();
+        }
+        restoreResolutionAndPalette(&screenContext);
+        return 1;
+    }
+
     unsigned char *rom_memory = NULL;
+    unsigned long requests_done = 0;
     unsigned char *data = NULL;
     long file_size = 0;
 
@@ -570,6 +1008,10 @@ int run()
         if (file_size != 128 * 1024)
         {
             printf("x Error: testrom.bin must be 128KB\r\n");
+            if (remote_mode)
+            {
+                sendRemoteLine("ERR testrom.bin must be 128KB");
+            }
         }
         else
         {
@@ -579,48 +1021,67 @@ int run()
             rom_memory = (unsigned char *)ROM_MEMORY_START;
             printf("- ROM memory address final release: %p\r\n", (void *)rom_memory);
 
-            testDifferentVersions(rom_memory);
-
-            // Sequential access tests
-            // Words access
-            testSequentialReadROM(rom_memory, data, ROM4_BANK);
-            testSequentialReadROM(rom_memory, data, ROM3_BANK);
-            testSequentialReadROMStats(rom_memory, data, ROM4_BANK);
-            testSequentialReadROMStats(rom_memory, data, ROM3_BANK);
-            // Bytes access
-            testSequentialReadROMBytes(rom_memory, data, ROM4_BANK);
-            testSequentialReadROMBytes(rom_memory, data, ROM3_BANK);
-            testSequentialReadROMBytesStats(rom_memory, data, ROM4_BANK);
-            testSequentialReadROMBytesStats(rom_memory, data, ROM3_BANK);
-
-            // Random access tests
-            // Words access
-            testRandomReadROM(rom_memory, data, ROM4_BANK, RANDOM_ACCESS_ITERATIONS);
-            testRandomReadROM(rom_memory, data, ROM3_BANK, RANDOM_ACCESS_ITERATIONS);
-            testRandomReadROMStats(rom_memory, data, ROM4_BANK, RANDOM_ACCESS_ITERATIONS);
-            testRandomReadROMStats(rom_memory, data, ROM3_BANK, RANDOM_ACCESS_ITERATIONS);
-            // Bytes access
-            testRandomReadROMBytes(rom_memory, data, ROM4_BANK, RANDOM_ACCESS_ITERATIONS);
-            testRandomReadROMBytes(rom_memory, data, ROM3_BANK, RANDOM_ACCESS_ITERATIONS);
-            testRandomReadROMBytesStats(rom_memory, data, ROM4_BANK, RANDOM_ACCESS_ITERATIONS);
-            testRandomReadROMBytesStats(rom_memory, data, ROM3_BANK, RANDOM_ACCESS_ITERATIONS);
-
-            // By address line tests
-            testAddressLinesSequentialReadROM(rom_memory, data, ROM4_BANK, ADDRESS_LINE_ITERATIONS);
-            testAddressLinesSequentialReadROM(rom_memory, data, ROM3_BANK, ADDRESS_LINE_ITERATIONS);
+            int version_failed = testDifferentVersions(rom_memory);
+
+            if (remote_mode)
+            {
+                runRemote(rom_memory, data, version_failed);
+            }
+            else if (contention_mode)
+            {
+                testContention(rom_memory, data);
+            }
+            else
+            {
+                // Sequential access tests
+                // Words access
+                testSequentialReadROM(rom_memory, data, ROM4_BANK, &requests_done);
+                testSequentialReadROM(rom_memory, data, ROM3_BANK, &requests_done);
+                testSequentialReadROMStats(rom_memory, data, ROM4_BANK, &requests_done);
+                testSequentialReadROMStats(rom_memory, data, ROM3_BANK, &requests_done);
+                // Bytes access
+                testSequentialReadROMBytes(rom_memory, data, ROM4_BANK, &requests_done);
+                testSequentialReadROMBytes(rom_memory, data, ROM3_BANK, &requests_done);
+                testSequentialReadROMBytesStats(rom_memory, data, ROM4_BANK, &requests_done);
+                testSequentialReadROMBytesStats(rom_memory, data, ROM3_BANK, &requests_done);
+
+                // Random access tests
+                // Words access
+                testRandomReadROM(rom_memory, data, ROM4_BANK, random_access_iterations, &requests_done);
+                testRandomReadROM(rom_memory, data, ROM3_BANK, random_access_iterations, &requests_done);
+                testRandomReadROMStats(rom_memory, data, ROM4_BANK, random_access_iterations, &requests_done);
+                testRandomReadROMStats(rom_memory, data, ROM3_BANK, random_access_iterations, &requests_done);
+                // Bytes access
+                testRandomReadROMBytes(rom_memory, data, ROM4_BANK, random_access_iterations, &requests_done);
+                testRandomReadROMBytes(rom_memory, data, ROM3_BANK, random_access_iterations, &requests_done);
+                testRandomReadROMBytesStats(rom_memory, data, ROM4_BANK, random_access_iterations, &requests_done);
+                testRandomReadROMBytesStats(rom_memory, data, ROM3_BANK, random_access_iterations, &requests_done);
+
+                // By address line tests
+                testAddressLinesSequentialReadROM(rom_memory, data, ROM4_BANK, address_line_iterations, &requests_done);
+                testAddressLinesSequentialReadROM(rom_memory, data, ROM3_BANK, address_line_iterations, &requests_done);
+            }
         }
     }
     else
     {
         printf("x Error: testrom.bin not found\r\n");
+        if (remote_mode)
+        {
+            sendRemoteLine("ERR testrom.bin not found");
+        }
     }
 
     // Clean up
     free(data);
 
-    printf("Press any key to exit...\r\n");
+    // Nobody is watching the screen of a remote station
+    if (!remote_mode)
+    {
+        printf("Press any key to exit...\r\n");
 
-    getchar();
+        getchar();
+    }
 
     restoreResolutionAndPalette(&screenContext);
 }
@@ -629,6 +1090,25 @@ int run()
 // Standard C entry point
 int main(int argc, char *argv[])
 {
+    for (int i = 1; i < argc; i++)
+    {
+        if (argv[i][0] == '-' && (argv[i][1] == 'C' || argv[i][1] == 'c'))
+        {
+            contention_mode = 1; // Read the ROM under interrupts and DMA traffic
+        }
+        if (argv[i][0] == '-' && (argv[i][1] == 'B' || argv[i][1] == 'b'))
+        {
+            if (!parseTimeBudget(&argv[i][2], &time_budget))
+            {
+                invalid_budget = argv[i]; // The screen is not ready yet, run() reports it
+            }
+        }
+        if (argv[i][0] == '-' && (argv[i][1] == 'R' || argv[i][1] == 'r'))
+        {
+            remote_mode = 1; // Take the commands from the RS-232 port
+        }
+    }
+
     // switching to supervisor mode and execute run()
     // needed because of direct memory access for reading/writing the palette
     Supexec(&run);
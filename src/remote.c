@@ -0,0 +1,44 @@
+#include <osbind.h>
+#include "remote.h"
+
+void initRemote()
+{
+    Rsconf(RS232_19200, RS232_NO_FLOW, RS232_UCR_8N1, RS232_UNCHANGED, RS232_UNCHANGED, RS232_UNCHANGED);
+    while (Bconstat(AUX_DEVICE))
+    {
+        Bconin(AUX_DEVICE);
+    }
+}
+
+int readRemoteLine(char *line, int size)
+{
+    int length = 0;
+    for (;;)
+    {
+        char c = (char)(Bconin(AUX_DEVICE) & 0xFF);
+        if (c == '\r' || c == '\n')
+        {
+            if (length == 0)
+            {
+                continue; // Skip empty lines and the LF of a CR/LF pair
+            }
+            break;
+        }
+        if (length < size - 1)
+        {
+            line[length++] = c;
+        }
+    }
+    line[length] = '\0';
+    return length;
+}
+
+void sendRemoteLine(const char *line)
+{
+    while (*line)
+    {
+        Bconout(AUX_DEVICE, *line++);
+    }
+    Bconout(AUX_DEVICE, '\r');
+    Bconout(AUX_DEVICE, '\n');
+}
@@ -0,0 +1,24 @@
+#ifndef REMOTE_H_
+#define REMOTE_H_
+
+#include <sys/types.h>
+
+/* SERIAL PORT DEFINITIONS */
+#define AUX_DEVICE 1       // Bconin/Bconout device for the RS-232 port
+#define RS232_19200 0      // Rsconf baud rate code for 19200 bauds
+#define RS232_NO_FLOW 0    // No handshake
+#define RS232_UCR_8N1 0x88 // MFP UCR: clock/16, 8 data bits, 1 stop bit, no parity
+#define RS232_UNCHANGED -1
+
+#define REMOTE_LINE_SIZE 80
+
+// configures the RS-232 port at 19200 bauds 8N1 without handshake and discards any pending input
+void initRemote();
+
+// reads a command line from the RS-232 port, without the CR/LF terminator. Blocks until a full line arrives
+int readRemoteLine(char *line, int size);
+
+// sends a record line to the RS-232 port, terminated with CR/LF
+void sendRemoteLine(const char *line);
+
+#endif
@@ -0,0 +1,189 @@
+"""Drives several TESTSCRT.TOS stations in remote mode (-R) over their RS-232 ports.
+
+Each station is given as NAME=DEVICE for a serial port, or NAME=INPUT:OUTPUT for a pair
+of files or pipes, e.g. the --rs232-out and --rs232-in files of a Hatari instance. A spec
+that names an existing path is always a serial device, even if it contains colons like the
+/dev/serial/by-path names.
+
+A station that stays silent for --timeout seconds is reported as NO RESULT.
+
+Example:
+    python src/remote_host.py --iter 100000 --seed 1234 st1=/dev/ttyUSB0 st2=/dev/ttyUSB1
+"""
+
+import argparse
+import errno
+import fcntl
+import os
+import select
+import stat
+import sys
+import termios
+import threading
+import time
+
+BAUD_RATE = termios.B19200
+
+
+def open_serial(device):
+    fd = os.open(device, os.O_RDWR | os.O_NOCTTY)
+    if os.isatty(fd):
+        attrs = termios.tcgetattr(fd)
+        attrs[0] = 0  # iflag
+        attrs[1] = 0  # oflag
+        attrs[2] = termios.CS8 | termios.CREAD | termios.CLOCAL  # cflag: 8N1, no handshake
+        attrs[3] = 0  # lflag: raw
+        attrs[4] = BAUD_RATE
+        attrs[5] = BAUD_RATE
+        attrs[6][termios.VMIN] = 1  # Block until a byte arrives, the timeouts use select()
+        attrs[6][termios.VTIME] = 0
+        termios.tcsetattr(fd, termios.TCSANOW, attrs)
+    return os.fdopen(fd, "rb", buffering=0), os.fdopen(os.dup(fd), "wb", buffering=0)
+
+
+def open_pipe_writer(path, deadline):
+    # Opening a named pipe for writing blocks until the station opens it for reading
+    while True:
+        try:
+            fd = os.open(path, os.O_WRONLY | os.O_NONBLOCK)
+            break
+        except OSError as e:
+            if e.errno != errno.ENXIO or time.monotonic() > deadline:
+                raise
+            time.sleep(0.1)
+    fcntl.fcntl(fd, fcntl.F_SETFL, fcntl.fcntl(fd, fcntl.F_GETFL) & ~os.O_NONBLOCK)
+    return os.fdopen(fd, "wb", buffering=0)
+
+
+def open_station(spec, deadline):
+    if os.path.exists(spec) or ":" not in spec:
+        return open_serial(spec)
+    station_input, station_output = spec.split(":", 1)
+    # Non blocking open, so a named pipe without writer does not hang the script
+    fd = os.open(station_input, os.O_RDONLY | os.O_NONBLOCK)
+    fcntl.fcntl(fd, fcntl.F_SETFL, fcntl.fcntl(fd, fcntl.F_GETFL) & ~os.O_NONBLOCK)
+    return os.fdopen(fd, "rb", buffering=0), open_pipe_writer(station_output, deadline)
+
+
+class Station:
+    def __init__(self, name, spec, timeout):
+        self.name = name
+        self.spec = spec
+        self.timeout = timeout
+        self.reader = None
+        self.writer = None
+        self.failed = None
+
+    def open(self):
+        self.reader, self.writer = open_station(self.spec, time.monotonic() + self.timeout)
+        # Regular files (and pipes without a writer yet) read as empty until the station writes
+        self.polled = stat.S_ISREG(os.fstat(self.reader.fileno()).st_mode) or stat.S_ISFIFO(
+            os.fstat(self.reader.fileno()).st_mode
+        )
+
+    def read_byte(self, deadline):
+        while True:
+            remaining = deadline - time.monotonic()
+            if remaining <= 0:
+                raise TimeoutError("%s: no data for %d seconds" % (self.name, self.timeout))
+            ready, _, _ = select.select([self.reader], [], [], remaining)
+            if ready:
+                c = self.reader.read(1)
+                if c:
+                    return c
+                if not self.polled:
+                    raise EOFError("%s: connection closed" % self.name)
+                time.sleep(min(0.1, remaining))
+
+    def read_line(self):
+        line = bytearray()
+        deadline = time.monotonic() + self.timeout
+        while True:
+            c = self.read_byte(deadline)
+            if c in b"\r\n":
+                if line:
+                    return line.decode("ascii", "replace")
+                continue
+            line += c
+
+    def command(self, command):
+        self.writer.write(command.encode("ascii") + b"\r\n")
+        line = self.read_line()
+        if line.startswith("ERR"):
+            raise RuntimeError("%s: %s -> %s" % (self.name, command, line))
+        return line
+
+    def log(self, message):
+        print("%s: %s" % (self.name, message), flush=True)
+
+    def run(self, args):
+        try:
+            self.open()
+            self.session(args)
+        except Exception as e:
+            self.log("ERROR %s" % e)
+
+    def session(self, args):
+        hello = self.read_line()
+        if not hello.startswith("HELLO"):
+            raise RuntimeError("%s: unexpected greeting %s" % (self.name, hello))
+        self.log(hello)
+        # VER OK <version>, or ERR version <rom version>. A mismatch is also counted in END
+        self.log(self.read_line())
+        if args.seed is not None:
+            self.command("SEED %d" % args.seed)
+        if args.iter is not None:
+            self.command("ITER %d" % args.iter)
+        if args.budget is not None:
+            self.command("BUDGET %d" % args.budget)
+        if args.tests is not None:
+            self.command("TESTS 0x%x" % args.tests)
+        self.writer.write(b"RUN\r\n")
+        while True:
+            line = self.read_line()
+            self.log(line)
+            if line.startswith("END"):
+                self.failed = int(line.split()[1])
+                break
+            if line.startswith("ERR"):
+                raise RuntimeError("%s: %s" % (self.name, line))
+        self.command("QUIT")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--seed", type=int, help="seed of the random tests, 0 for a new seed on every test")
+    parser.add_argument("--iter", type=int, help="iterations of the random access and address line tests")
+    parser.add_argument("--budget", type=int, help="time budget in seconds of the random access and address line tests")
+    parser.add_argument("--tests", type=lambda x: int(x, 0), help="bit mask of the test numbers to run")
+    parser.add_argument("--timeout", type=int, default=300, help="seconds a station can stay silent (default 300)")
+    parser.add_argument("stations", nargs="+", metavar="NAME=DEVICE|NAME=INPUT:OUTPUT")
+    args = parser.parse_args()
+
+    for spec in args.stations:
+        name, _, device = spec.partition("=")
+        if not name or not device:
+            parser.error("invalid station %r, expected NAME=DEVICE or NAME=INPUT:OUTPUT" % spec)
+    stations = [Station(*spec.split("=", 1), timeout=args.timeout) for spec in args.stations]
+    threads = []
+    for station in stations:
+        thread = threading.Thread(target=station.run, args=(args,), daemon=True)
+        thread.start()
+        threads.append(thread)
+    for thread in threads:
+        thread.join()
+
+    exit_code = 0
+    for station in stations:
+        if station.failed is None:
+            print("%s: NO RESULT" % station.name)
+            exit_code = 1
+        else:
+            print("%s: %s (%d failed)" % (station.name, "FAIL" if station.failed else "PASS", station.failed))
+            if station.failed:
+                exit_code = 1
+    sys.exit(exit_code)
+
+
+if __name__ == "__main__":
+    main()